@@ -4,6 +4,9 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
 #include <GL/glew.h>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -17,6 +20,7 @@
 #include <opencv2/opencv.hpp>
 #include <optional>
 #include <stdio.h>
+#include <string>
 #include <vector>
 extern "C"
 {
@@ -36,14 +40,218 @@ struct FRAME
   GLuint texture_;
 };
 
+struct STREAM_PARAMETERS
+{
+  STREAM_PARAMETERS() :
+    codec_id_(AV_CODEC_ID_NONE),
+    width_(0),
+    height_(0),
+    format_(-1)
+  {
+  }
+
+  AVCodecID codec_id_;
+  int width_;
+  int height_;
+  int format_;
+  std::vector<uint8_t> extradata_;
+};
+
+std::string StreamParametersPath(const std::string& url)
+{
+  return "DewarpingPlayer_" + std::to_string(std::hash<std::string>()(url)) + ".cache";
+}
+
+std::optional<STREAM_PARAMETERS> LoadStreamParameters(const std::string& url)
+{
+  std::ifstream file(StreamParametersPath(url), std::ios::binary);
+  if (!file)
+  {
+    return std::nullopt;
+  }
+  STREAM_PARAMETERS parameters;
+  int32_t codec_id = 0;
+  int32_t extradata_size = 0;
+  file.read(reinterpret_cast<char*>(&codec_id), sizeof(codec_id));
+  file.read(reinterpret_cast<char*>(&parameters.width_), sizeof(parameters.width_));
+  file.read(reinterpret_cast<char*>(&parameters.height_), sizeof(parameters.height_));
+  file.read(reinterpret_cast<char*>(&parameters.format_), sizeof(parameters.format_));
+  file.read(reinterpret_cast<char*>(&extradata_size), sizeof(extradata_size));
+  if (!file || (parameters.width_ <= 0) || (parameters.height_ <= 0) || (extradata_size < 0) || (extradata_size > (1024 * 1024)))
+  {
+    return std::nullopt;
+  }
+  parameters.codec_id_ = static_cast<AVCodecID>(codec_id);
+  parameters.extradata_.resize(extradata_size);
+  file.read(reinterpret_cast<char*>(parameters.extradata_.data()), extradata_size);
+  if (!file)
+  {
+    return std::nullopt;
+  }
+  return parameters;
+}
+
+void SaveStreamParameters(const std::string& url, const AVCodecParameters* codecpar)
+{
+  std::ofstream file(StreamParametersPath(url), std::ios::binary | std::ios::trunc);
+  const int32_t codec_id = static_cast<int32_t>(codecpar->codec_id);
+  const int32_t extradata_size = static_cast<int32_t>(codecpar->extradata_size);
+  file.write(reinterpret_cast<const char*>(&codec_id), sizeof(codec_id));
+  file.write(reinterpret_cast<const char*>(&codecpar->width), sizeof(codecpar->width));
+  file.write(reinterpret_cast<const char*>(&codecpar->height), sizeof(codecpar->height));
+  file.write(reinterpret_cast<const char*>(&codecpar->format), sizeof(codecpar->format));
+  file.write(reinterpret_cast<const char*>(&extradata_size), sizeof(extradata_size));
+  file.write(reinterpret_cast<const char*>(codecpar->extradata), extradata_size);
+  if (!file)
+  {
+    std::cerr << "Failed to save stream parameters" << std::endl;
+  }
+}
+
+AVFormatContext* OpenInput(const char* url, const bool probe)
+{
+  AVFormatContext* format_context = nullptr;
+  AVDictionary* options = nullptr;
+  av_dict_set(&options, "rtsp_transport", "tcp", 0);
+  av_dict_set(&options, "stimeout", "5000000", 0);
+  if (probe)
+  {
+    av_dict_set(&options, "analyzeduration", "10000000", 0);
+    av_dict_set(&options, "probesize", "50M", 0);
+  }
+  else
+  {
+    av_dict_set(&options, "analyzeduration", "0", 0);
+    av_dict_set(&options, "probesize", "32", 0);
+  }
+  if (avformat_open_input(&format_context, url, nullptr, &options) < 0)
+  {
+    std::cerr << "Failed to open file" << std::endl;
+    av_dict_free(&options);
+    return nullptr;
+  }
+  av_dict_free(&options);
+  if (probe && (avformat_find_stream_info(format_context, nullptr) < 0))
+  {
+    std::cerr << "Failed to find stream info" << std::endl;
+    avformat_close_input(&format_context);
+    return nullptr;
+  }
+  return format_context;
+}
+
+AVCodecContext* OpenDecoder(AVFormatContext* format_context, const STREAM_PARAMETERS* cached_parameters, std::optional<unsigned int>& video_stream)
+{
+  for (unsigned int i = 0; i < format_context->nb_streams; i++)
+  {
+    if (format_context->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
+    {
+      video_stream = i;
+      break;
+    }
+  }
+  if (!video_stream.has_value())
+  {
+    std::cerr << "Failed to find video stream" << std::endl;
+    return nullptr;
+  }
+  // Apply cached parameters
+  AVCodecParameters* codecpar = format_context->streams[*video_stream]->codecpar;
+  if (cached_parameters)
+  {
+    if ((codecpar->codec_id != AV_CODEC_ID_NONE) && (codecpar->codec_id != cached_parameters->codec_id_))
+    {
+      std::cerr << "Cached codec does not match stream" << std::endl;
+      return nullptr;
+    }
+    codecpar->codec_id = cached_parameters->codec_id_;
+    codecpar->width = cached_parameters->width_;
+    codecpar->height = cached_parameters->height_;
+    codecpar->format = cached_parameters->format_;
+    if ((codecpar->extradata == nullptr) && !cached_parameters->extradata_.empty())
+    {
+      codecpar->extradata = static_cast<uint8_t*>(av_mallocz(cached_parameters->extradata_.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+      if (codecpar->extradata == nullptr)
+      {
+        std::cerr << "Failed to allocate extradata" << std::endl;
+        return nullptr;
+      }
+      std::copy(cached_parameters->extradata_.begin(), cached_parameters->extradata_.end(), codecpar->extradata);
+      codecpar->extradata_size = static_cast<int>(cached_parameters->extradata_.size());
+    }
+  }
+  // Open the decoder
+  const AVCodec* codec = avcodec_find_decoder(codecpar->codec_id);
+  if (codec == nullptr)
+  {
+    std::cerr << "Failed to find decoder" << std::endl;
+    return nullptr;
+  }
+  AVCodecContext* codec_context = avcodec_alloc_context3(codec);
+  if (codec_context == nullptr)
+  {
+    std::cerr << "Failed to allocate codec context" << std::endl;
+    return nullptr;
+  }
+  // Copy codec parameters
+  if (avcodec_parameters_to_context(codec_context, codecpar) < 0)
+  {
+    std::cerr << "Failed to copy codec parameters" << std::endl;
+    avcodec_free_context(&codec_context);
+    return nullptr;
+  }
+  if (avcodec_open2(codec_context, codec, nullptr) < 0)
+  {
+    std::cerr << "Failed to open codec" << std::endl;
+    avcodec_free_context(&codec_context);
+    return nullptr;
+  }
+  return codec_context;
+}
+
+bool DecodeFirstKeyframe(AVFormatContext* format_context, const unsigned int video_stream, AVCodecContext* codec_context, AVPacket* av_packet, AVFrame* av_frame)
+{
+  bool keyframe = false;
+  for (int i = 0; i < 1000; ++i)
+  {
+    if (av_read_frame(format_context, av_packet) < 0)
+    {
+      return false;
+    }
+    // Skip until the first keyframe
+    if ((av_packet->stream_index != video_stream) || (!keyframe && !(av_packet->flags & AV_PKT_FLAG_KEY)))
+    {
+      av_packet_unref(av_packet);
+      continue;
+    }
+    keyframe = true;
+    const int send = avcodec_send_packet(codec_context, av_packet);
+    av_packet_unref(av_packet);
+    if (send < 0)
+    {
+      return false;
+    }
+    const int receive = avcodec_receive_frame(codec_context, av_frame);
+    if (receive == 0)
+    {
+      return true;
+    }
+    else if (receive != AVERROR(EAGAIN))
+    {
+      return false;
+    }
+  }
+  return false;
+}
+
 void GenerateLinearLUT(const int video_width, const int video_height, uint8_t* dewarp_lut)
 {
   for (int y = 0; y < video_height; ++y)
   {
     for (int x = 0; x < video_width; ++x)
     {
-      const uint16_t value_x = static_cast<uint16_t>((static_cast<float>(x) / static_cast<float>(video_width)) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
-      const uint16_t value_y = static_cast<uint16_t>((static_cast<float>(y) / static_cast<float>(video_height)) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+      const uint16_t value_x = static_cast<uint16_t>((((static_cast<float>(x) / static_cast<float>(video_width)) + 0.5f) / 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+      const uint16_t value_y = static_cast<uint16_t>((((static_cast<float>(y) / static_cast<float>(video_height)) + 0.5f) / 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
       const int index = ((y * video_width) + x) * 4;
       dewarp_lut[index] = reinterpret_cast<const uint8_t*>(&value_x)[0];
       dewarp_lut[index + 1] = reinterpret_cast<const uint8_t*>(&value_x)[1];
@@ -53,21 +261,24 @@ void GenerateLinearLUT(const int video_width, const int video_height, uint8_t* d
   }
 }
 
-void GenerateUndistortLUT(const float zoom, const int video_width, const int video_height, const cv::Mat& camera_matrix, const cv::Mat& distortion_coeffs, uint8_t* dewarp_lut)
+void GenerateUndistortLUT(const float lut_zoom, const int video_width, const int video_height, const cv::Mat& camera_matrix, const cv::Mat& distortion_coeffs, uint8_t* dewarp_lut)
 {
   cv::Mat map1;
   cv::Mat map2;
-  cv::initUndistortRectifyMap(camera_matrix, distortion_coeffs, cv::Mat(), camera_matrix, cv::Size(video_width, video_height), CV_32FC1, map1, map2);
+  cv::Mat new_camera_matrix = camera_matrix.clone();
+  new_camera_matrix.at<double>(0, 0) *= lut_zoom;
+  new_camera_matrix.at<double>(1, 1) *= lut_zoom;
+  cv::initUndistortRectifyMap(camera_matrix, distortion_coeffs, cv::Mat(), new_camera_matrix, cv::Size(video_width, video_height), CV_32FC1, map1, map2);
   for (int y = 0; y < video_height; ++y)
   {
     for (int x = 0; x < video_width; ++x)
     {
       float undistorted_x = map1.at<float>(y, x) / static_cast<float>(video_width);
       float undistorted_y = map2.at<float>(y, x) / static_cast<float>(video_height);
-      undistorted_x = std::max(std::min(((undistorted_x - 0.5f) * zoom) + 0.5f, 1.0f), 0.0f);
-      undistorted_y = std::max(std::min(((undistorted_y - 0.5f) * zoom) + 0.5f, 1.0f), 0.0f);
-      const uint16_t value_x = static_cast<uint16_t>(undistorted_x * static_cast<float>(std::numeric_limits<uint16_t>::max()));
-      const uint16_t value_y = static_cast<uint16_t>(undistorted_y * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+      undistorted_x = std::max(std::min(undistorted_x, 1.5f), -0.5f);
+      undistorted_y = std::max(std::min(undistorted_y, 1.5f), -0.5f);
+      const uint16_t value_x = static_cast<uint16_t>(((undistorted_x + 0.5f) / 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+      const uint16_t value_y = static_cast<uint16_t>(((undistorted_y + 0.5f) / 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
       const int index = ((y * video_width) + x) * 4;
       dewarp_lut[index] = reinterpret_cast<const uint8_t*>(&value_x)[0];
       dewarp_lut[index + 1] = reinterpret_cast<const uint8_t*>(&value_x)[1];
@@ -77,21 +288,24 @@ void GenerateUndistortLUT(const float zoom, const int video_width, const int vid
   }
 }
 
-void GenerateFisheyeLUT(const float zoom, const int video_width, const int video_height, const cv::Mat& camera_matrix, const cv::Mat& distortion_coeffs, uint8_t* dewarp_lut)
+void GenerateFisheyeLUT(const float lut_zoom, const int video_width, const int video_height, const cv::Mat& camera_matrix, const cv::Mat& distortion_coeffs, uint8_t* dewarp_lut)
 {
   cv::Mat map1;
   cv::Mat map2;
-  cv::fisheye::initUndistortRectifyMap(camera_matrix, distortion_coeffs, cv::Mat(), camera_matrix, cv::Size(video_width, video_height), CV_32FC1, map1, map2);
+  cv::Mat new_camera_matrix = camera_matrix.clone();
+  new_camera_matrix.at<double>(0, 0) *= lut_zoom;
+  new_camera_matrix.at<double>(1, 1) *= lut_zoom;
+  cv::fisheye::initUndistortRectifyMap(camera_matrix, distortion_coeffs, cv::Mat(), new_camera_matrix, cv::Size(video_width, video_height), CV_32FC1, map1, map2);
   for (int y = 0; y < video_height; ++y)
   {
     for (int x = 0; x < video_width; ++x)
     {
       float undistorted_x = map1.at<float>(y, x) / static_cast<float>(video_width);
       float undistorted_y = map2.at<float>(y, x) / static_cast<float>(video_height);
-      undistorted_x = std::max(std::min(((undistorted_x - 0.5f) * zoom) + 0.5f, 1.0f), 0.0f);
-      undistorted_y = std::max(std::min(((undistorted_y - 0.5f) * zoom) + 0.5f, 1.0f), 0.0f);
-      const uint16_t value_x = static_cast<uint16_t>(undistorted_x * static_cast<float>(std::numeric_limits<uint16_t>::max()));
-      const uint16_t value_y = static_cast<uint16_t>(undistorted_y * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+      undistorted_x = std::max(std::min(undistorted_x, 1.5f), -0.5f);
+      undistorted_y = std::max(std::min(undistorted_y, 1.5f), -0.5f);
+      const uint16_t value_x = static_cast<uint16_t>(((undistorted_x + 0.5f) / 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+      const uint16_t value_y = static_cast<uint16_t>(((undistorted_y + 0.5f) / 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
       const int index = ((y * video_width) + x) * 4;
       dewarp_lut[index] = reinterpret_cast<const uint8_t*>(&value_x)[0];
       dewarp_lut[index + 1] = reinterpret_cast<const uint8_t*>(&value_x)[1];
@@ -101,21 +315,24 @@ void GenerateFisheyeLUT(const float zoom, const int video_width, const int video
   }
 }
 
-void GenerateOmnidirectionalLUT(const float zoom, const float xi, const int video_width, const int video_height, const cv::Mat& camera_matrix, const cv::Mat& distortion_coeffs, uint8_t* dewarp_lut)
+void GenerateOmnidirectionalLUT(const float lut_zoom, const float xi, const int video_width, const int video_height, const cv::Mat& camera_matrix, const cv::Mat& distortion_coeffs, uint8_t* dewarp_lut)
 {
   cv::Mat map1;
   cv::Mat map2;
-  cv::omnidir::initUndistortRectifyMap(camera_matrix, distortion_coeffs, xi, cv::Matx33d::eye(), camera_matrix, cv::Size(video_width, video_height), CV_32FC1, map1, map2, cv::omnidir::RECTIFY_PERSPECTIVE);
+  cv::Mat new_camera_matrix = camera_matrix.clone();
+  new_camera_matrix.at<double>(0, 0) *= lut_zoom;
+  new_camera_matrix.at<double>(1, 1) *= lut_zoom;
+  cv::omnidir::initUndistortRectifyMap(camera_matrix, distortion_coeffs, xi, cv::Matx33d::eye(), new_camera_matrix, cv::Size(video_width, video_height), CV_32FC1, map1, map2, cv::omnidir::RECTIFY_PERSPECTIVE);
   for (int y = 0; y < video_height; ++y)
   {
     for (int x = 0; x < video_width; ++x)
     {
       float undistorted_x = map1.at<float>(y, x) / static_cast<float>(video_width);
       float undistorted_y = map2.at<float>(y, x) / static_cast<float>(video_height);
-      undistorted_x = std::max(std::min(((undistorted_x - 0.5f) * zoom) + 0.5f, 1.0f), 0.0f);
-      undistorted_y = std::max(std::min(((undistorted_y - 0.5f) * zoom) + 0.5f, 1.0f), 0.0f);
-      const uint16_t value_x = static_cast<uint16_t>(undistorted_x * static_cast<float>(std::numeric_limits<uint16_t>::max()));
-      const uint16_t value_y = static_cast<uint16_t>(undistorted_y * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+      undistorted_x = std::max(std::min(undistorted_x, 1.5f), -0.5f);
+      undistorted_y = std::max(std::min(undistorted_y, 1.5f), -0.5f);
+      const uint16_t value_x = static_cast<uint16_t>(((undistorted_x + 0.5f) / 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
+      const uint16_t value_y = static_cast<uint16_t>(((undistorted_y + 0.5f) / 2.0f) * static_cast<float>(std::numeric_limits<uint16_t>::max()));
       const int index = ((y * video_width) + x) * 4;
       dewarp_lut[index] = reinterpret_cast<const uint8_t*>(&value_x)[0];
       dewarp_lut[index + 1] = reinterpret_cast<const uint8_t*>(&value_x)[1];
@@ -125,69 +342,87 @@ void GenerateOmnidirectionalLUT(const float zoom, const float xi, const int vide
   }
 }
 
+cv::Matx33f GenerateViewTransform(const float pan, const float tilt, const float zoom, const float rotation, const float lut_zoom, const int video_width, const int video_height)
+{
+  // Map output coordinates to LUT coordinates
+  const float angle = rotation * static_cast<float>(CV_PI) / 180.0f;
+  const cv::Matx33f normalize(1.0f / static_cast<float>(video_width), 0.0f, 0.0f,
+                              0.0f, 1.0f / static_cast<float>(video_height), 0.0f,
+                              0.0f, 0.0f, 1.0f);
+  const cv::Matx33f denormalize(static_cast<float>(video_width), 0.0f, 0.0f,
+                                0.0f, static_cast<float>(video_height), 0.0f,
+                                0.0f, 0.0f, 1.0f);
+  const cv::Matx33f to_center(1.0f, 0.0f, -static_cast<float>(video_width) / 2.0f,
+                              0.0f, 1.0f, -static_cast<float>(video_height) / 2.0f,
+                              0.0f, 0.0f, 1.0f);
+  const float scale = lut_zoom / zoom;
+  const cv::Matx33f scale_rotate(std::cos(angle) * scale, -std::sin(angle) * scale, 0.0f,
+                                 std::sin(angle) * scale, std::cos(angle) * scale, 0.0f,
+                                 0.0f, 0.0f, 1.0f);
+  const cv::Matx33f from_center(1.0f, 0.0f, (0.5f + (pan * scale)) * static_cast<float>(video_width),
+                                0.0f, 1.0f, (0.5f - (tilt * scale)) * static_cast<float>(video_height),
+                                0.0f, 0.0f, 1.0f);
+  return normalize * from_center * scale_rotate * to_center * denormalize;
+}
+
 int main(int argc, char** argv)
 {
   // Check command line arguments
-  if (argc != 2)
+  const bool fast_start = (argc == 3) && (std::string(argv[1]) == "--fast-start");
+  if ((argc != 2) && !fast_start)
   {
-    std::cerr << "Usage:\nImGuiPlayer video.mp4" << std::endl;
+    std::cerr << "Usage:\nImGuiPlayer [--fast-start] video.mp4" << std::endl;
     return -1;
   }
-  // Parse file with FFMPEG
+  const char* url = argv[argc - 1];
+  const std::chrono::steady_clock::time_point open_time = std::chrono::steady_clock::now();
+  AVPacket* av_packet = av_packet_alloc();
+  AVFrame* av_frame = av_frame_alloc();
+  // Open the stream
   AVFormatContext* format_context = nullptr;
-  AVDictionary* options = nullptr;
-  av_dict_set(&options, "rtsp_transport", "tcp", 0);
-  av_dict_set(&options, "stimeout", "5000000", 0);
-  av_dict_set(&options, "analyzeduration", "10000000", 0);
-  av_dict_set(&options, "probesize", "50M", 0);
-  if (avformat_open_input(&format_context, argv[1], nullptr, &options) < 0)
-  {
-    std::cerr << "Failed to open file" << std::endl;
-    return -1;
-  }
-  av_dict_free(&options);
-  if (avformat_find_stream_info(format_context, nullptr) < 0)
-  {
-    std::cerr << "Failed to find stream info" << std::endl;
-    return -1;
-  }
+  AVCodecContext* codec_context = nullptr;
   std::optional<unsigned int> video_stream;
-  for (unsigned int i = 0; i < format_context->nb_streams; i++)
+  bool first_frame_pending = false;
+  if (fast_start)
   {
-    if (format_context->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO)
+    const std::optional<STREAM_PARAMETERS> cached_parameters = LoadStreamParameters(url);
+    if (cached_parameters.has_value())
     {
-      video_stream = i;
-      break;
+      format_context = OpenInput(url, false);
+      if (format_context == nullptr)
+      {
+        return -1;
+      }
+      codec_context = OpenDecoder(format_context, &*cached_parameters, video_stream);
+      if (codec_context && DecodeFirstKeyframe(format_context, *video_stream, codec_context, av_packet, av_frame) && (av_frame->width == cached_parameters->width_) && (av_frame->height == cached_parameters->height_) && (av_frame->format == cached_parameters->format_))
+      {
+        first_frame_pending = true;
+      }
+      else
+      {
+        std::cerr << "Cached stream parameters failed, falling back to full probe" << std::endl;
+        avcodec_free_context(&codec_context);
+        avformat_close_input(&format_context);
+        video_stream.reset();
+      }
     }
   }
-  if (!video_stream.has_value())
-  {
-    std::cerr << "Failed to find video stream" << std::endl;
-    return -1;
-  }
-  // Open the decoder
-  const AVCodec* codec = avcodec_find_decoder(format_context->streams[*video_stream]->codecpar->codec_id);
-  if (codec == nullptr)
-  {
-    std::cerr << "Failed to find decoder" << std::endl;
-    return -1;
-  }
-  AVCodecContext* codec_context = avcodec_alloc_context3(codec);
-  if (codec_context == nullptr)
-  {
-    std::cerr << "Failed to allocate codec context" << std::endl;
-    return -1;
-  }
-  // Copy codec parameters
-  if (avcodec_parameters_to_context(codec_context, format_context->streams[*video_stream]->codecpar) < 0)
+  if (!first_frame_pending)
   {
-    std::cerr << "Failed to copy codec parameters" << std::endl;
-    return -1;
-  }
-  if (avcodec_open2(codec_context, codec, nullptr) < 0)
-  {
-    std::cerr << "Failed to open codec" << std::endl;
-    return -1;
+    format_context = OpenInput(url, true);
+    if (format_context == nullptr)
+    {
+      return -1;
+    }
+    codec_context = OpenDecoder(format_context, nullptr, video_stream);
+    if (codec_context == nullptr)
+    {
+      return -1;
+    }
+    if (fast_start)
+    {
+      SaveStreamParameters(url, format_context->streams[*video_stream]->codecpar);
+    }
   }
   // Init window
   if (!glfwInit())
@@ -294,12 +529,17 @@ int main(int argc, char** argv)
                                                  out vec4 FragColor;
                                                  uniform sampler2D tex;
                                                  uniform sampler2D lut;
+                                                 uniform mat3 view;
                                                  void main()
                                                  {
-                                                   vec4 lut_value = texture(lut, tex_coord);
-                                                   float x = lut_value.g + (lut_value.r / 255.0);
-                                                   float y = lut_value.a + (lut_value.b / 255.0);
-                                                   FragColor = texture(tex, vec2(x, y));
+                                                   vec2 lut_coord = (view * vec3(tex_coord, 1.0)).xy;
+                                                   vec2 uv = (texture(lut, lut_coord).rg * 2.0) - 0.5;
+                                                   if (any(lessThan(lut_coord, vec2(0.0))) || any(greaterThan(lut_coord, vec2(1.0))) || any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))))
+                                                   {
+                                                     FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+                                                     return;
+                                                   }
+                                                   FragColor = texture(tex, uv);
                                                  })";
   const GLuint dewarp_vertex_shader = glCreateShader(GL_VERTEX_SHADER);
   glShaderSource(dewarp_vertex_shader, 1, &dewarp_vertex_shader_source, nullptr);
@@ -313,6 +553,169 @@ int main(int argc, char** argv)
   glLinkProgram(dewarp_shader_program);
   glDeleteShader(dewarp_vertex_shader);
   glDeleteShader(dewarp_fragment_shader);
+  // Compute shader
+  const char* compute_shader_source = R"(#version 430 core
+                                         layout(local_size_x = 16, local_size_y = 16) in;
+                                         layout(rgba8, binding = 0) writeonly uniform image2D frame_image;
+                                         layout(rgba8, binding = 1) writeonly uniform image2D dewarp_image;
+                                         uniform sampler2D texture_y;
+                                         uniform sampler2D texture_u;
+                                         uniform sampler2D texture_v;
+                                         uniform sampler2D lut;
+                                         uniform mat3 view;
+                                         const int LUMA_STAGE_SIZE = 48;
+                                         const int CHROMA_STAGE_SIZE = 26;
+                                         shared float stage_y[LUMA_STAGE_SIZE * LUMA_STAGE_SIZE];
+                                         shared float stage_u[CHROMA_STAGE_SIZE * CHROMA_STAGE_SIZE];
+                                         shared float stage_v[CHROMA_STAGE_SIZE * CHROMA_STAGE_SIZE];
+                                         shared int luma_min_x;
+                                         shared int luma_min_y;
+                                         shared int luma_max_x;
+                                         shared int luma_max_y;
+                                         shared int chroma_min_x;
+                                         shared int chroma_min_y;
+                                         shared int chroma_max_x;
+                                         shared int chroma_max_y;
+                                         vec4 YUVToRGB(float y, float u, float v)
+                                         {
+                                           vec3 rgb = mat3(1.0, 1.0, 1.0,
+                                                           0.0, -0.39465, 2.03211,
+                                                           1.13983, -0.58060, 0.0) * vec3(y, u - 0.5, v - 0.5);
+                                           return vec4(rgb, 1.0);
+                                         }
+                                         float StagedY(ivec2 texel)
+                                         {
+                                           return stage_y[(texel.y * LUMA_STAGE_SIZE) + texel.x];
+                                         }
+                                         vec2 StagedUV(ivec2 texel)
+                                         {
+                                           int index = (texel.y * CHROMA_STAGE_SIZE) + texel.x;
+                                           return vec2(stage_u[index], stage_v[index]);
+                                         }
+                                         float BilinearY(vec2 pos, ivec2 origin, ivec2 max_texel)
+                                         {
+                                           ivec2 t0 = ivec2(floor(pos));
+                                           ivec2 t1 = min(t0 + 1, max_texel) - origin;
+                                           t0 -= origin;
+                                           vec2 f = fract(pos);
+                                           return mix(mix(StagedY(t0), StagedY(ivec2(t1.x, t0.y)), f.x), mix(StagedY(ivec2(t0.x, t1.y)), StagedY(t1), f.x), f.y);
+                                         }
+                                         vec2 BilinearUV(vec2 pos, ivec2 origin, ivec2 max_texel)
+                                         {
+                                           ivec2 t0 = ivec2(floor(pos));
+                                           ivec2 t1 = min(t0 + 1, max_texel) - origin;
+                                           t0 -= origin;
+                                           vec2 f = fract(pos);
+                                           return mix(mix(StagedUV(t0), StagedUV(ivec2(t1.x, t0.y)), f.x), mix(StagedUV(ivec2(t0.x, t1.y)), StagedUV(t1), f.x), f.y);
+                                         }
+                                         void main()
+                                         {
+                                           ivec2 size = imageSize(dewarp_image);
+                                           ivec2 pixel = ivec2(gl_GlobalInvocationID.xy);
+                                           bool inside = all(lessThan(pixel, size));
+                                           vec2 tex_coord = (vec2(pixel) + 0.5) / vec2(size);
+                                           vec2 lut_coord = (view * vec3(tex_coord, 1.0)).xy;
+                                           bool visible = inside && all(greaterThanEqual(lut_coord, vec2(0.0))) && all(lessThanEqual(lut_coord, vec2(1.0)));
+                                           ivec2 luma_max_texel = textureSize(texture_y, 0) - 1;
+                                           ivec2 chroma_max_texel = textureSize(texture_u, 0) - 1;
+                                           if (gl_LocalInvocationIndex == 0u)
+                                           {
+                                             luma_min_x = luma_min_y = chroma_min_x = chroma_min_y = 0x7fffffff;
+                                             luma_max_x = luma_max_y = chroma_max_x = chroma_max_y = 0;
+                                           }
+                                           memoryBarrierShared();
+                                           barrier();
+                                           // Gather the footprint of this tile in both planes
+                                           vec2 uv = vec2(0.0);
+                                           vec2 luma_pos = vec2(0.0);
+                                           vec2 chroma_pos = vec2(0.0);
+                                           if (visible)
+                                           {
+                                             uv = (textureLod(lut, lut_coord, 0.0).rg * 2.0) - 0.5;
+                                             visible = all(greaterThanEqual(uv, vec2(0.0))) && all(lessThanEqual(uv, vec2(1.0)));
+                                           }
+                                           if (visible)
+                                           {
+                                             luma_pos = clamp((uv * vec2(luma_max_texel + 1)) - 0.5, vec2(0.0), vec2(luma_max_texel));
+                                             chroma_pos = clamp((uv * vec2(chroma_max_texel + 1)) - 0.5, vec2(0.0), vec2(chroma_max_texel));
+                                             ivec2 luma_min = ivec2(floor(luma_pos));
+                                             ivec2 luma_max = min(luma_min + 1, luma_max_texel);
+                                             ivec2 chroma_min = ivec2(floor(chroma_pos));
+                                             ivec2 chroma_max = min(chroma_min + 1, chroma_max_texel);
+                                             atomicMin(luma_min_x, luma_min.x);
+                                             atomicMin(luma_min_y, luma_min.y);
+                                             atomicMax(luma_max_x, luma_max.x);
+                                             atomicMax(luma_max_y, luma_max.y);
+                                             atomicMin(chroma_min_x, chroma_min.x);
+                                             atomicMin(chroma_min_y, chroma_min.y);
+                                             atomicMax(chroma_max_x, chroma_max.x);
+                                             atomicMax(chroma_max_y, chroma_max.y);
+                                           }
+                                           memoryBarrierShared();
+                                           barrier();
+                                           ivec2 luma_origin = ivec2(luma_min_x, luma_min_y);
+                                           ivec2 luma_extent = ivec2(luma_max_x, luma_max_y) - luma_origin + 1;
+                                           ivec2 chroma_origin = ivec2(chroma_min_x, chroma_min_y);
+                                           ivec2 chroma_extent = ivec2(chroma_max_x, chroma_max_y) - chroma_origin + 1;
+                                           bool staged = all(greaterThan(luma_extent, ivec2(0))) && all(lessThanEqual(luma_extent, ivec2(LUMA_STAGE_SIZE))) && all(lessThanEqual(chroma_extent, ivec2(CHROMA_STAGE_SIZE)));
+                                           // Stage the footprint into shared memory
+                                           if (staged)
+                                           {
+                                             for (int i = int(gl_LocalInvocationIndex); i < (luma_extent.x * luma_extent.y); i += 256)
+                                             {
+                                               ivec2 offset = ivec2(i % luma_extent.x, i / luma_extent.x);
+                                               stage_y[(offset.y * LUMA_STAGE_SIZE) + offset.x] = texelFetch(texture_y, luma_origin + offset, 0).r;
+                                             }
+                                             for (int i = int(gl_LocalInvocationIndex); i < (chroma_extent.x * chroma_extent.y); i += 256)
+                                             {
+                                               ivec2 offset = ivec2(i % chroma_extent.x, i / chroma_extent.x);
+                                               stage_u[(offset.y * CHROMA_STAGE_SIZE) + offset.x] = texelFetch(texture_u, chroma_origin + offset, 0).r;
+                                               stage_v[(offset.y * CHROMA_STAGE_SIZE) + offset.x] = texelFetch(texture_v, chroma_origin + offset, 0).r;
+                                             }
+                                           }
+                                           memoryBarrierShared();
+                                           barrier();
+                                           if (!inside)
+                                           {
+                                             return;
+                                           }
+                                           // Frame view
+                                           imageStore(frame_image, pixel, YUVToRGB(texelFetch(texture_y, pixel, 0).r, textureLod(texture_u, tex_coord, 0.0).r, textureLod(texture_v, tex_coord, 0.0).r));
+                                           // Dewarp view
+                                           if (!visible)
+                                           {
+                                             imageStore(dewarp_image, pixel, vec4(0.0, 0.0, 0.0, 1.0));
+                                           }
+                                           else if (staged)
+                                           {
+                                             vec2 chroma = BilinearUV(chroma_pos, chroma_origin, chroma_max_texel);
+                                             imageStore(dewarp_image, pixel, YUVToRGB(BilinearY(luma_pos, luma_origin, luma_max_texel), chroma.x, chroma.y));
+                                           }
+                                           else
+                                           {
+                                             vec2 luma_coord = (luma_pos + 0.5) / vec2(luma_max_texel + 1);
+                                             imageStore(dewarp_image, pixel, YUVToRGB(textureLod(texture_y, luma_coord, 0.0).r, textureLod(texture_u, luma_coord, 0.0).r, textureLod(texture_v, luma_coord, 0.0).r));
+                                           }
+                                         })";
+  GLuint compute_shader_program = GL_INVALID_VALUE;
+  if (GLEW_VERSION_4_3)
+  {
+    const GLuint compute_shader = glCreateShader(GL_COMPUTE_SHADER);
+    glShaderSource(compute_shader, 1, &compute_shader_source, nullptr);
+    glCompileShader(compute_shader);
+    compute_shader_program = glCreateProgram();
+    glAttachShader(compute_shader_program, compute_shader);
+    glLinkProgram(compute_shader_program);
+    glDeleteShader(compute_shader);
+    GLint link_status = GL_FALSE;
+    glGetProgramiv(compute_shader_program, GL_LINK_STATUS, &link_status);
+    if (link_status != GL_TRUE)
+    {
+      std::cerr << "Failed to link compute shader, compute backend disabled" << std::endl;
+      glDeleteProgram(compute_shader_program);
+      compute_shader_program = GL_INVALID_VALUE;
+    }
+  }
   // Dewarp textures
   std::unique_ptr<uint8_t[]> dewarp_lut = std::make_unique<uint8_t[]>(video_width * video_height * sizeof(uint16_t) * 2);
   GenerateLinearLUT(video_width, video_height, dewarp_lut.get());
@@ -323,7 +726,7 @@ int main(int argc, char** argv)
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, video_width, video_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, dewarp_lut.get());
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16, video_width, video_height, 0, GL_RG, GL_UNSIGNED_SHORT, dewarp_lut.get());
   // YUV Geometory
   const float yuv_vertices[] =
   {
@@ -393,7 +796,7 @@ int main(int argc, char** argv)
     glBindFramebuffer(GL_FRAMEBUFFER, frame.framebuffer_);
     glGenTextures(1, &frame.texture_);
     glBindTexture(GL_TEXTURE_2D, frame.texture_);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, video_width, video_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, video_width, video_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, frame.texture_, 0);
@@ -404,43 +807,114 @@ int main(int argc, char** argv)
     }
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
   }
+  // Timer query
+  GLuint timer_query = GL_INVALID_VALUE;
+  glGenQueries(1, &timer_query);
+  bool timer_query_pending = false;
+  int timer_query_backend = 0;
+  std::array<double, 2> backend_times_ms = { 0.0, 0.0 };
+  int current_backend = 0;
+  // Virtual pan, tilt, zoom and rotation
+  float pan = 0.0f;
+  float tilt = 0.0f;
+  float zoom = 1.0f;
+  float rotation = 0.0f;
+  // LUT field of view
+  const float lens_lut_zoom = 0.25f;
+  float lut_zoom = 1.0f;
+  cv::Matx33f view_transform = GenerateViewTransform(pan, tilt, zoom, rotation, lut_zoom, video_width, video_height);
+  std::optional<double> time_to_first_frame_ms;
+  // Dewarp the current frame
+  const auto dewarp = [&]()
+  {
+    if (current_backend == 0)
+    {
+      // Draw dewarp
+      glBindFramebuffer(GL_FRAMEBUFFER, frames[1].framebuffer_);
+      glUseProgram(dewarp_shader_program);
+      // Bind textures
+      glActiveTexture(GL_TEXTURE0);
+      glBindTexture(GL_TEXTURE_2D, frames[0].texture_);
+      glUniform1i(glGetUniformLocation(dewarp_shader_program, "tex"), 0);
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D, dewarp_lut_texture);
+      glUniform1i(glGetUniformLocation(dewarp_shader_program, "lut"), 1);
+      glUniformMatrix3fv(glGetUniformLocation(dewarp_shader_program, "view"), 1, GL_TRUE, view_transform.val);
+      // Draw
+      glBindVertexArray(dewarp_vao);
+      glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+      glBindVertexArray(0);
+      // Clean up
+      glUseProgram(0);
+      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    else
+    {
+      // Convert and dewarp both views in one dispatch
+      glUseProgram(compute_shader_program);
+      // Bind textures
+      glActiveTexture(GL_TEXTURE0);
+      glBindTexture(GL_TEXTURE_2D, yuv_textures[0]);
+      glUniform1i(glGetUniformLocation(compute_shader_program, "texture_y"), 0);
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D, yuv_textures[1]);
+      glUniform1i(glGetUniformLocation(compute_shader_program, "texture_u"), 1);
+      glActiveTexture(GL_TEXTURE2);
+      glBindTexture(GL_TEXTURE_2D, yuv_textures[2]);
+      glUniform1i(glGetUniformLocation(compute_shader_program, "texture_v"), 2);
+      glActiveTexture(GL_TEXTURE3);
+      glBindTexture(GL_TEXTURE_2D, dewarp_lut_texture);
+      glUniform1i(glGetUniformLocation(compute_shader_program, "lut"), 3);
+      glUniformMatrix3fv(glGetUniformLocation(compute_shader_program, "view"), 1, GL_TRUE, view_transform.val);
+      glBindImageTexture(0, frames[0].texture_, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+      glBindImageTexture(1, frames[1].texture_, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+      // Dispatch
+      glDispatchCompute((video_width + 15) / 16, (video_height + 15) / 16, 1);
+      glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+      // Clean up
+      glActiveTexture(GL_TEXTURE0);
+      glUseProgram(0);
+    }
+  };
   // Main loop
-  AVPacket* av_packet = av_packet_alloc();
-  AVFrame* av_frame = av_frame_alloc();
   const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
   while (!glfwWindowShouldClose(window))
   {
     // Decode and build some frames if needed
-    int ret = av_read_frame(format_context, av_packet);
-    if (ret && (ret != AVERROR_EOF))
+    if (!first_frame_pending)
     {
-      break;
-    }
-    else
-    {
-      if (av_packet->stream_index != *video_stream)
+      int ret = av_read_frame(format_context, av_packet);
+      if (ret && (ret != AVERROR_EOF))
       {
-        continue;
+        break;
       }
-      // Send packets
-      if (avcodec_send_packet(codec_context, av_packet))
+      else
       {
-        break;
+        if (av_packet->stream_index != *video_stream)
+        {
+          continue;
+        }
+        // Send packets
+        if (avcodec_send_packet(codec_context, av_packet))
+        {
+          break;
+        }
       }
     }
     // Collect frames
+    bool frame_decoded = false;
     glViewport(0, 0, video_width, video_height);
     while (true)
     {
-      // Draw YUV
-      if (avcodec_receive_frame(codec_context, av_frame))
+      if (first_frame_pending)
+      {
+        first_frame_pending = false;
+      }
+      else if (avcodec_receive_frame(codec_context, av_frame))
       {
         break;
       }
       // Update textures with AVFrame data
-      glBindFramebuffer(GL_FRAMEBUFFER, frames[0].framebuffer_);
-      glUseProgram(yuv_shader_program);
-      // Bind textures
       glBindTexture(GL_TEXTURE_2D, yuv_textures[0]);
       glPixelStorei(GL_UNPACK_ROW_LENGTH, av_frame->linesize[0]);
       glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, av_frame->width, av_frame->height, GL_RED, GL_UNSIGNED_BYTE, av_frame->data[0]);
@@ -450,40 +924,59 @@ int main(int argc, char** argv)
       glBindTexture(GL_TEXTURE_2D, yuv_textures[2]);
       glPixelStorei(GL_UNPACK_ROW_LENGTH, av_frame->linesize[2]);
       glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, av_frame->width / 2, av_frame->height / 2, GL_RED, GL_UNSIGNED_BYTE, av_frame->data[2]);
-      glActiveTexture(GL_TEXTURE0);
-      glBindTexture(GL_TEXTURE_2D, yuv_textures[0]);
-      glUniform1i(glGetUniformLocation(yuv_shader_program, "texture_y"), 0);
-      glActiveTexture(GL_TEXTURE1);
-      glBindTexture(GL_TEXTURE_2D, yuv_textures[1]);
-      glUniform1i(glGetUniformLocation(yuv_shader_program, "texture_u"), 1);
-      glActiveTexture(GL_TEXTURE2);
-      glBindTexture(GL_TEXTURE_2D, yuv_textures[2]);
-      glUniform1i(glGetUniformLocation(yuv_shader_program, "texture_v"), 2);
-      // Draw
-      glBindVertexArray(yuv_vao);
-      glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-      glBindVertexArray(0);
-      // Clean up
       glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
-      glUseProgram(0);
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
-      // Draw dewarp
-      glBindFramebuffer(GL_FRAMEBUFFER, frames[1].framebuffer_);
-      glUseProgram(dewarp_shader_program);
-      // Bind textures
-      glActiveTexture(GL_TEXTURE0);
-      glBindTexture(GL_TEXTURE_2D, frames[0].texture_);
-      glUniform1i(glGetUniformLocation(dewarp_shader_program, "tex"), 0);
-      glActiveTexture(GL_TEXTURE1);
-      glBindTexture(GL_TEXTURE_2D, dewarp_lut_texture);
-      glUniform1i(glGetUniformLocation(dewarp_shader_program, "lut"), 1);
-      // Draw
-      glBindVertexArray(dewarp_vao);
-      glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-      glBindVertexArray(0);
-      // Clean up
-      glUseProgram(0);
-      glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      // Time the conversion and dewarp
+      const bool time_frame = !timer_query_pending;
+      if (time_frame)
+      {
+        glBeginQuery(GL_TIME_ELAPSED, timer_query);
+      }
+      if (current_backend == 0)
+      {
+        // Draw YUV
+        glBindFramebuffer(GL_FRAMEBUFFER, frames[0].framebuffer_);
+        glUseProgram(yuv_shader_program);
+        // Bind textures
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, yuv_textures[0]);
+        glUniform1i(glGetUniformLocation(yuv_shader_program, "texture_y"), 0);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, yuv_textures[1]);
+        glUniform1i(glGetUniformLocation(yuv_shader_program, "texture_u"), 1);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_2D, yuv_textures[2]);
+        glUniform1i(glGetUniformLocation(yuv_shader_program, "texture_v"), 2);
+        // Draw
+        glBindVertexArray(yuv_vao);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+        // Clean up
+        glUseProgram(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+      }
+      dewarp();
+      if (time_frame)
+      {
+        glEndQuery(GL_TIME_ELAPSED);
+        timer_query_pending = true;
+        timer_query_backend = current_backend;
+      }
+      frame_decoded = true;
+    }
+    // Collect timing result
+    if (timer_query_pending)
+    {
+      GLint available = GL_FALSE;
+      glGetQueryObjectiv(timer_query, GL_QUERY_RESULT_AVAILABLE, &available);
+      if (available)
+      {
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(timer_query, GL_QUERY_RESULT, &elapsed);
+        const double elapsed_ms = static_cast<double>(elapsed) / 1000000.0;
+        double& backend_time = backend_times_ms[timer_query_backend];
+        backend_time = (backend_time == 0.0) ? elapsed_ms : ((backend_time * 0.95) + (elapsed_ms * 0.05));
+        timer_query_pending = false;
+      }
     }
     glViewport(0, 0, display_width, display_height);
     // ImGui stuff
@@ -508,6 +1001,42 @@ int main(int argc, char** argv)
     // Draw setup window
     ImGui::SetNextWindowSize(ImVec2(0, 0), ImGuiCond_Once);
     ImGui::Begin("Setup");
+    const char* backends[] = { "fragment", "compute" };
+    if (ImGui::BeginCombo("Backend", backends[current_backend]))
+    {
+      for (int n = 0; n < IM_ARRAYSIZE(backends); n++)
+      {
+        const bool is_selected = (current_backend == n);
+        const bool is_supported = (n == 0) || (compute_shader_program != GL_INVALID_VALUE);
+        if (ImGui::Selectable(backends[n], is_selected, is_supported ? 0 : ImGuiSelectableFlags_Disabled))
+        {
+          current_backend = n;
+        }
+      }
+      ImGui::EndCombo();
+    }
+    ImGui::Text("fragment: %.3f ms compute: %.3f ms", backend_times_ms[0], backend_times_ms[1]);
+    if (time_to_first_frame_ms.has_value())
+    {
+      ImGui::Text("Time to first frame: %.0f ms", *time_to_first_frame_ms);
+    }
+    bool view_changed = false;
+    if (ImGui::DragFloat("pan", &pan, 0.001f, -2.0f, 2.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp))
+    {
+      view_changed = true;
+    }
+    if (ImGui::DragFloat("tilt", &tilt, 0.001f, -2.0f, 2.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp))
+    {
+      view_changed = true;
+    }
+    if (ImGui::DragFloat("zoom", &zoom, 0.01f, lens_lut_zoom, 4.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp))
+    {
+      view_changed = true;
+    }
+    if (ImGui::DragFloat("rotation", &rotation, 0.1f, -180.0f, 180.0f, "%.3f", ImGuiSliderFlags_AlwaysClamp))
+    {
+      view_changed = true;
+    }
     static int current_mode = 0;
     const char* items[] = { "linear", "opencv undistort", "opencv fisheye", "opencv omnidir" };
     bool redraw = false;
@@ -529,17 +1058,14 @@ int main(int argc, char** argv)
       if (redraw)
       {
         GenerateLinearLUT(video_width, video_height, dewarp_lut.get());
+        lut_zoom = 1.0f;
+        view_changed = true;
         glBindTexture(GL_TEXTURE_2D, dewarp_lut_texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, video_width, video_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, dewarp_lut.get());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16, video_width, video_height, 0, GL_RG, GL_UNSIGNED_SHORT, dewarp_lut.get());
       }
     }
     else if (current_mode == 1)
     {
-      static float zoom = 1.0f;
-      if (ImGui::DragFloat("distort_zoom", &zoom, 0.01, 0.5f, 1.5f))
-      {
-        redraw = true;
-      }
       static float focal_length = 1700.0f;
       if (ImGui::DragFloat("distort_focal_length", &focal_length, 1.0f, 500.0f, 3000.0f))
       {
@@ -576,18 +1102,15 @@ int main(int argc, char** argv)
                                                                  0,            focal_length, static_cast<float>(video_height) / 2.0f,
                                                                  0,            0,            1);
         const cv::Mat distortion_coeffs = (cv::Mat_<double>(1, 5) << radial_1, radial_2, tangential_1, tangential_2, radial_3);
-        GenerateUndistortLUT(zoom, video_width, video_height, camera_matrix, distortion_coeffs, dewarp_lut.get());
+        GenerateUndistortLUT(lens_lut_zoom, video_width, video_height, camera_matrix, distortion_coeffs, dewarp_lut.get());
+        lut_zoom = lens_lut_zoom;
+        view_changed = true;
         glBindTexture(GL_TEXTURE_2D, dewarp_lut_texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, video_width, video_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, dewarp_lut.get());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16, video_width, video_height, 0, GL_RG, GL_UNSIGNED_SHORT, dewarp_lut.get());
       }
     }
     else if (current_mode == 2)
     {
-      static float zoom = 1.0f;
-      if (ImGui::DragFloat("fisheye_zoom", &zoom, 0.01, 0.5f, 1.5f))
-      {
-        redraw = true;
-      }
       static float focal_length = 1700.0f;
       if (ImGui::DragFloat("fisheye_focal_length", &focal_length, 1.0f, 500.0f, 3000.0f))
       {
@@ -619,18 +1142,15 @@ int main(int argc, char** argv)
                                                                  0,            focal_length, static_cast<float>(video_height) / 2.0f,
                                                                  0,            0,            1);
         const cv::Mat distortion_coeffs = (cv::Mat_<double>(1, 4) << k1, k2, k3, k4);
-        GenerateFisheyeLUT(zoom, video_width, video_height, camera_matrix, distortion_coeffs, dewarp_lut.get());
+        GenerateFisheyeLUT(lens_lut_zoom, video_width, video_height, camera_matrix, distortion_coeffs, dewarp_lut.get());
+        lut_zoom = lens_lut_zoom;
+        view_changed = true;
         glBindTexture(GL_TEXTURE_2D, dewarp_lut_texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, video_width, video_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, dewarp_lut.get());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16, video_width, video_height, 0, GL_RG, GL_UNSIGNED_SHORT, dewarp_lut.get());
       }
     }
     else if (current_mode == 3)
     {
-      static float zoom = 1.0f;
-      if (ImGui::DragFloat("omnidirectional_zoom", &zoom, 0.01, 0.5f, 4.0f))
-      {
-        redraw = true;
-      }
       static float xi = 1.2f;
       if (ImGui::DragFloat("omnidirectional_xi", &xi, 0.01, 0.5f, 1.5f))
       {
@@ -667,11 +1187,20 @@ int main(int argc, char** argv)
                                                                  0,            focal_length, static_cast<float>(video_height) / 2.0f,
                                                                  0,            0,            1);
         const cv::Mat distortion_coeffs = (cv::Mat_<double>(1, 4) << k1, k2, p1, p2);
-        GenerateOmnidirectionalLUT(zoom, xi, video_width, video_height, camera_matrix, distortion_coeffs, dewarp_lut.get());
+        GenerateOmnidirectionalLUT(lens_lut_zoom, xi, video_width, video_height, camera_matrix, distortion_coeffs, dewarp_lut.get());
+        lut_zoom = lens_lut_zoom;
+        view_changed = true;
         glBindTexture(GL_TEXTURE_2D, dewarp_lut_texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, video_width, video_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, dewarp_lut.get());
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16, video_width, video_height, 0, GL_RG, GL_UNSIGNED_SHORT, dewarp_lut.get());
       }
     }
+    if (view_changed)
+    {
+      view_transform = GenerateViewTransform(pan, tilt, zoom, rotation, lut_zoom, video_width, video_height);
+      glViewport(0, 0, video_width, video_height);
+      dewarp();
+      glViewport(0, 0, display_width, display_height);
+    }
     ImGui::End();
     ImGui::EndFrame();
     // Rendering
@@ -679,6 +1208,12 @@ int main(int argc, char** argv)
     glClear(GL_COLOR_BUFFER_BIT);
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     glfwSwapBuffers(window);
+    // Measure time to first frame
+    if (frame_decoded && !time_to_first_frame_ms.has_value())
+    {
+      time_to_first_frame_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - open_time).count();
+      std::cout << "Time to first frame: " << *time_to_first_frame_ms << "ms" << std::endl;
+    }
   }
   // Cleanup
   glDeleteProgram(yuv_shader_program);
@@ -687,6 +1222,11 @@ int main(int argc, char** argv)
   glDeleteBuffers(1, &yuv_vbo);
   glDeleteBuffers(1, &yuv_ebo);
   glDeleteProgram(dewarp_shader_program);
+  if (compute_shader_program != GL_INVALID_VALUE)
+  {
+    glDeleteProgram(compute_shader_program);
+  }
+  glDeleteQueries(1, &timer_query);
   glDeleteTextures(1, &dewarp_lut_texture);
   glDeleteVertexArrays(1, &dewarp_vao);
   glDeleteBuffers(1, &dewarp_vbo);